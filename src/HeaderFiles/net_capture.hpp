@@ -0,0 +1,250 @@
+#pragma once
+
+#include "net_common.hpp"
+#include "net_message.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace olc {
+namespace net {
+// A capture is an append-only log of framed messages, exactly as they crossed
+// the wire, so real traffic can be fed back into a server later on.
+//
+// File:   [capture_file_header] [record] [record] ...
+// Record: [capture_record_header] [message_header<T> bytes] [body bytes]
+//
+// A record with nHeaderSize == 0 marks the end of the log - the file is grown
+// in large zero filled chunks, and only trimmed when the writer is closed.
+
+enum class capture_direction : uint8_t { inbound, outbound };
+
+struct capture_file_header {
+  char sMagic[8] = {'O', 'L', 'C', 'C', 'A', 'P', '0', '1'};
+  // Wall clock time the capture started, in nanoseconds since the epoch
+  int64_t nStartTime = 0;
+};
+
+struct capture_record_header {
+  // Nanoseconds since the capture started
+  uint64_t nTimestamp = 0;
+  // Connection the message belongs to, as given by connection<T>::GetID()
+  uint32_t nConnectionID = 0;
+  capture_direction nDirection = capture_direction::inbound;
+  uint8_t nReserved[3] = {};
+  uint32_t nHeaderSize = 0;
+  uint32_t nBodySize = 0;
+};
+
+// Appends records to a memory mapped capture file. Thread safe, so one writer
+// can be shared by every connection of a server.
+class capture_writer {
+public:
+  capture_writer(const std::string &sFileName,
+                 size_t nInitialSize = 64 * 1024 * 1024)
+      : m_sFileName(sFileName) {
+    // Create the file, and make it big enough for the first chunk of records
+    { std::ofstream file(m_sFileName, std::ios::binary | std::ios::trunc); }
+    m_nCapacity = std::max(nInitialSize, sizeof(capture_file_header) +
+                                             sizeof(capture_record_header));
+    Map();
+
+    capture_file_header header;
+    header.nStartTime =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    std::memcpy(Data(), &header, sizeof(header));
+    m_nUsed = sizeof(header);
+  }
+
+  capture_writer(const capture_writer &) = delete;
+
+  virtual ~capture_writer() { Close(); }
+
+public:
+  // Appends one framed message to the log
+  template <typename T>
+  void Append(uint32_t nConnectionID, capture_direction nDirection,
+              const message<T> &msg) {
+    capture_record_header record;
+    record.nConnectionID = nConnectionID;
+    record.nDirection = nDirection;
+    record.nHeaderSize = sizeof(message_header<T>);
+    record.nBodySize = uint32_t(msg.body.size());
+
+    size_t nRecordSize = sizeof(record) + record.nHeaderSize + record.nBodySize;
+
+    std::scoped_lock lock(muxFile);
+    if (!m_region)
+      return;
+
+    // Stamped under the lock, so timestamps never go backwards along the log
+    record.nTimestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - m_tpStart)
+                            .count();
+
+    // Always leave room for an empty record at the end, so readers know
+    // where to stop
+    if (m_nUsed + nRecordSize + sizeof(capture_record_header) > m_nCapacity &&
+        !Grow(nRecordSize))
+      return;
+
+    uint8_t *p = Data() + m_nUsed;
+    std::memcpy(p, &record, sizeof(record));
+    std::memcpy(p + sizeof(record), &msg.header, record.nHeaderSize);
+    if (record.nBodySize > 0)
+      std::memcpy(p + sizeof(record) + record.nHeaderSize, msg.body.data(),
+                  record.nBodySize);
+    m_nUsed += nRecordSize;
+  }
+
+  // Flushes the log and trims the file down to what was actually written
+  void Close() {
+    std::scoped_lock lock(muxFile);
+    if (!m_region)
+      return;
+
+    m_region->flush();
+    m_region.reset();
+
+    // Not worth throwing over, readers stop at the first empty record anyway
+    std::error_code ec;
+    std::filesystem::resize_file(m_sFileName, m_nUsed, ec);
+  }
+
+  // Number of bytes written to the log so far
+  size_t Size() {
+    std::scoped_lock lock(muxFile);
+    return m_nUsed;
+  }
+
+private:
+  uint8_t *Data() { return static_cast<uint8_t *>(m_region->get_address()); }
+
+  // Makes the file m_nCapacity bytes long. On Linux the disk space is really
+  // allocated, otherwise a full disk would only show up later as a SIGBUS when
+  // a record is written into the mapping
+  void Reserve() {
+#ifdef __linux__
+    int fd = ::open(m_sFileName.c_str(), O_RDWR);
+    if (fd < 0)
+      throw std::system_error(errno, std::generic_category(), m_sFileName);
+    int nError = ::posix_fallocate(fd, 0, off_t(m_nCapacity));
+    ::close(fd);
+    if (nError != 0)
+      throw std::system_error(nError, std::generic_category(), m_sFileName);
+#else
+    std::filesystem::resize_file(m_sFileName, m_nCapacity);
+#endif
+  }
+
+  void Map() {
+    Reserve();
+    boost::interprocess::file_mapping file(m_sFileName.c_str(),
+                                           boost::interprocess::read_write);
+    m_region = std::make_unique<boost::interprocess::mapped_region>(
+        file, boost::interprocess::read_write);
+  }
+
+  // Doubles the size of the file until nRecordSize more bytes fit, and maps
+  // it again. Append() runs inside the connections' asio handlers, so this
+  // must never throw - if the file can't grow (disk full, say), capturing
+  // simply stops, and what was written so far is kept
+  bool Grow(size_t nRecordSize) {
+    while (m_nUsed + nRecordSize + sizeof(capture_record_header) > m_nCapacity)
+      m_nCapacity *= 2;
+
+    m_region.reset();
+    try {
+      Map();
+    } catch (std::exception &e) {
+      std::cerr << "[CAPTURE] Stopped, could not grow " << m_sFileName << ": "
+                << e.what() << "\n";
+      m_region.reset();
+
+      std::error_code ec;
+      std::filesystem::resize_file(m_sFileName, m_nUsed, ec);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  std::string m_sFileName;
+  std::chrono::steady_clock::time_point m_tpStart =
+      std::chrono::steady_clock::now();
+
+  std::mutex muxFile;
+  std::unique_ptr<boost::interprocess::mapped_region> m_region;
+  size_t m_nCapacity = 0;
+  size_t m_nUsed = 0;
+};
+
+// Walks the records of a capture file, without copying any of them
+class capture_reader {
+public:
+  // A record as it sits in the mapped file
+  struct record {
+    capture_record_header info;
+    const uint8_t *pHeader = nullptr;
+    const uint8_t *pBody = nullptr;
+  };
+
+public:
+  capture_reader(const std::string &sFileName)
+      : m_file(sFileName.c_str(), boost::interprocess::read_only),
+        m_region(m_file, boost::interprocess::read_only) {
+    if (m_region.get_size() < sizeof(capture_file_header) ||
+        std::memcmp(m_region.get_address(), capture_file_header().sMagic,
+                    sizeof(capture_file_header::sMagic)) != 0)
+      throw std::runtime_error("Not a capture file: " + sFileName);
+
+    std::memcpy(&m_header, m_region.get_address(), sizeof(m_header));
+    m_nOffset = sizeof(m_header);
+  }
+
+public:
+  const capture_file_header &Header() const { return m_header; }
+
+  // Returns the next record, or nothing once the end of the log is reached
+  std::optional<record> Next() {
+    const uint8_t *pData = static_cast<const uint8_t *>(m_region.get_address());
+    size_t nSize = m_region.get_size();
+
+    record r;
+    if (m_nOffset + sizeof(r.info) > nSize)
+      return std::nullopt;
+    std::memcpy(&r.info, pData + m_nOffset, sizeof(r.info));
+
+    size_t nRecordSize = sizeof(r.info) + size_t(r.info.nHeaderSize) +
+                         size_t(r.info.nBodySize);
+    if (r.info.nHeaderSize == 0 || m_nOffset + nRecordSize > nSize)
+      return std::nullopt;
+
+    r.pHeader = pData + m_nOffset + sizeof(r.info);
+    r.pBody = r.pHeader + r.info.nHeaderSize;
+    m_nOffset += nRecordSize;
+    return r;
+  }
+
+  // Go back to the first record
+  void Rewind() { m_nOffset = sizeof(m_header); }
+
+private:
+  boost::interprocess::file_mapping m_file;
+  boost::interprocess::mapped_region m_region;
+  capture_file_header m_header;
+  size_t m_nOffset = 0;
+};
+} // namespace net
+} // namespace olc
@@ -15,6 +15,10 @@ public:
   }
 
 public:
+  // Decide what happens if the link to the server drops, see reconnect_policy.
+  // Takes effect on the next call to Connect()
+  void SetReconnectPolicy(const reconnect_policy &policy) { m_policy = policy; }
+
   // Connect to server with hostname/ip-address and port
   bool Connect(const std::string &host, const uint16_t port) {
     try {
@@ -27,6 +31,7 @@ public:
       m_connection = std::make_unique<connection<T>>(
           connection<T>::owner::client, m_context,
           boost::asio::ip::tcp::socket(m_context), m_qMessagesIn);
+      m_connection->SetReconnectPolicy(m_policy);
 
       // Tell the connection object to connect to server
       m_connection->ConnectToServer(endpoints);
@@ -42,11 +47,10 @@ public:
 
   // Disconnect from server
   void Disconnect() {
-    // If connection exists, and it's connected then...
-    if (IsConnected()) {
-      // ...disconnect from server gracefully
+    // If connection exists then disconnect from server gracefully, this also
+    // stops it trying to reconnect
+    if (m_connection)
       m_connection->Disconnect();
-    }
 
     // Either way, we're also done with the asio context...
     m_context.stop();
@@ -67,9 +71,10 @@ public:
   }
 
 public:
-  // Send message to server
+  // Send message to server. While disconnected the message is only kept if
+  // the connection's reconnect policy replays messages, see IsReplaying()
   void Send(const message<T> &msg) {
-    if (IsConnected())
+    if (IsConnected() || (m_connection && m_connection->IsReplaying()))
       m_connection->Send(msg);
   }
 
@@ -84,6 +89,8 @@ protected:
   // The client has a single instance of a "connection" object, which handles
   // data transfer
   std::unique_ptr<connection<T>> m_connection;
+  // What to do when the connection drops
+  reconnect_policy m_policy;
 
 private:
   // This is the thread safe queue of incoming messages from server
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "net_common.hpp"
+#include "net_connection.hpp"
+
+namespace olc {
+namespace net {
+// A client that talks to one server over several connections at once. A
+// single TCP stream is limited by its own congestion window, so spreading
+// Send() across a handful of streams lets one process push more data. All
+// connections share one incoming queue, so to the user it looks just like a
+// client_interface.
+//
+// NOTE: Messages sent over different connections can arrive at the server in
+// a different order to how they were sent. Only messages that go over the
+// same connection keep their order.
+template <typename T> class client_pool {
+public:
+  // nConnections streams are opened to the server, serviced by nThreads asio
+  // contexts (each connection belongs to exactly one of them)
+  client_pool(size_t nConnections = 4, size_t nThreads = 1)
+      : m_nConnections(std::max<size_t>(nConnections, 1)) {
+    for (size_t i = 0; i < std::clamp<size_t>(nThreads, 1, m_nConnections);
+         i++)
+      m_vContexts.push_back(std::make_unique<boost::asio::io_context>());
+  }
+
+  virtual ~client_pool() {
+    // If the pool is destroyed, always try and disconnect from server
+    Disconnect();
+  }
+
+public:
+  // Applied to every connection in the pool, takes effect on the next call to
+  // Connect()
+  void SetReconnectPolicy(const reconnect_policy &policy) { m_policy = policy; }
+
+  // Connect all the pool's connections to server with hostname/ip-address and
+  // port. A pool that is already connected is disconnected first
+  bool Connect(const std::string &host, const uint16_t port) {
+    Disconnect();
+
+    try {
+      // Resolve hostname/ip-address once, every connection goes to the same
+      // place
+      boost::asio::ip::tcp::resolver resolver(*m_vContexts.front());
+      boost::asio::ip::tcp::resolver::results_type endpoints =
+          resolver.resolve(host, std::to_string(port));
+
+      // Create the connections, dealing them out between the contexts
+      for (size_t i = 0; i < m_nConnections; i++) {
+        auto &context = *m_vContexts[i % m_vContexts.size()];
+        m_vConnections.push_back(std::make_unique<connection<T>>(
+            connection<T>::owner::client, context,
+            boost::asio::ip::tcp::socket(context), m_qMessagesIn));
+        m_vConnections.back()->SetReconnectPolicy(m_policy);
+        m_vConnections.back()->ConnectToServer(endpoints);
+      }
+
+      // Start a thread per context
+      for (auto &context : m_vContexts)
+        m_vThreads.emplace_back([&context]() { context->run(); });
+    } catch (std::exception &e) {
+      std::cerr << "Client Pool Exception: " << e.what() << "\n";
+      return false;
+    }
+    return true;
+  }
+
+  // Disconnect every connection from server
+  void Disconnect() {
+    for (auto &conn : m_vConnections)
+      conn->Disconnect();
+
+    // We're also done with the asio contexts...
+    for (auto &context : m_vContexts)
+      context->stop();
+    // ...and their threads
+    for (auto &thr : m_vThreads)
+      if (thr.joinable())
+        thr.join();
+    m_vThreads.clear();
+
+    // Stopping leaves the closes posted above, and the handlers of whatever
+    // they aborted, sitting in the contexts - and they all point at the
+    // connections. Run them out now, so nothing is left to call into a
+    // destroyed connection, and the contexts are ready to run again
+    for (auto &context : m_vContexts) {
+      context->restart();
+      context->poll();
+      context->restart();
+    }
+
+    // Destroy the connection objects
+    m_vConnections.clear();
+  }
+
+  // Check if at least one connection is talking to the server
+  bool IsConnected() { return ConnectedCount() > 0; }
+
+  // Number of connections currently talking to the server
+  size_t ConnectedCount() {
+    return std::count_if(m_vConnections.begin(), m_vConnections.end(),
+                         [](auto &conn) { return conn->IsConnected(); });
+  }
+
+public:
+  // Send message to server, over the next live connection in turn. If none
+  // are live, the message is only kept if the connection's reconnect policy
+  // replays messages, see connection<T>::IsReplaying()
+  void Send(const message<T> &msg) {
+    if (m_vConnections.empty())
+      return;
+
+    size_t nStart = m_nNextConnection++;
+    for (size_t i = 0; i < m_vConnections.size(); i++) {
+      auto &conn = m_vConnections[(nStart + i) % m_vConnections.size()];
+      if (conn->IsConnected()) {
+        conn->Send(msg);
+        return;
+      }
+    }
+
+    auto &conn = m_vConnections[nStart % m_vConnections.size()];
+    if (conn->IsReplaying())
+      conn->Send(msg);
+  }
+
+  // Retrieve queue of messages from server, whichever connection they came in
+  // on
+  tsqueue<owned_message<T>> &Incoming() { return m_qMessagesIn; }
+
+protected:
+  // Each asio context runs in a thread of its own
+  std::vector<std::unique_ptr<boost::asio::io_context>> m_vContexts;
+  std::vector<std::thread> m_vThreads;
+
+  // The connections to the server, and where the next Send() goes
+  size_t m_nConnections = 0;
+  std::vector<std::unique_ptr<connection<T>>> m_vConnections;
+  std::atomic<size_t> m_nNextConnection = 0;
+
+  // What to do when a connection drops
+  reconnect_policy m_policy;
+
+private:
+  // This is the thread safe queue of incoming messages from server
+  tsqueue<owned_message<T>> m_qMessagesIn;
+};
+} // namespace net
+} // namespace olc
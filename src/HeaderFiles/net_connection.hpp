@@ -1,11 +1,51 @@
 #pragma once
 
+#include "net_capture.hpp"
 #include "net_common.hpp"
 #include "net_message.hpp"
 #include "net_tsqueue.hpp"
 
 namespace olc {
 namespace net {
+// Describes how a client side connection behaves when its link to the server
+// drops. By default nothing happens - the connection just stays closed, as it
+// always has. When enabled, the connection retries with exponential backoff,
+// and each delay is shortened by a random amount so that a crowd of clients
+// dropped at the same moment don't all come knocking at the same moment.
+struct reconnect_policy {
+  bool bEnabled = false;
+
+  // Delay before the first retry, it grows by fMultiplier each attempt up to
+  // maxDelay
+  std::chrono::milliseconds initialDelay{100};
+  std::chrono::milliseconds maxDelay{10000};
+  double fMultiplier = 2.0;
+
+  // Fraction of each delay that is randomised, 0 = none, 1 = "full jitter"
+  double fJitter = 0.5;
+
+  // Give up after this many failed attempts in a row, 0 = keep trying forever
+  size_t nMaxAttempts = 0;
+
+  // How many outgoing messages are held on to while the link is down, and
+  // replayed once it is back. 0 = messages sent while disconnected are
+  // discarded, as they are whenever bEnabled is false. When full, the oldest
+  // messages are dropped first.
+  size_t nReplayCapacity = 0;
+
+  // Works out how long to wait before retry number nAttempt (counting from 0)
+  template <typename Rng>
+  std::chrono::milliseconds Backoff(size_t nAttempt, Rng &rng) const {
+    double fDelay = double(initialDelay.count()) *
+                    std::pow(fMultiplier, double(nAttempt));
+    fDelay = std::min(fDelay, double(maxDelay.count()));
+
+    std::uniform_real_distribution<double> dist(
+        1.0 - std::clamp(fJitter, 0.0, 1.0), 1.0);
+    return std::chrono::milliseconds(int64_t(fDelay * dist(rng)));
+  }
+};
+
 template <typename T>
 class connection : public std::enable_shared_from_this<connection<T>> {
 public:
@@ -22,6 +62,10 @@ public:
       : m_asioContext(asioContext), m_socket(std::move(socket)),
         m_qMessagesIn(qIn) {
     m_nOwnerType = parent;
+
+    // A server is handed a socket that has already been accepted, so it is
+    // good to go straight away. A client has to wait for ConnectToServer()
+    m_bConnected = (parent == owner::server) && m_socket.is_open();
   }
 
   virtual ~connection() {}
@@ -30,6 +74,24 @@ public:
   // exist across the whole system.
   uint32_t GetID() const { return id; }
 
+  // Clients only - decide what happens when the link to the server drops.
+  // Must be set before ConnectToServer() is called
+  void SetReconnectPolicy(const reconnect_policy &policy) {
+    m_policy = policy;
+  }
+
+  // True if messages sent while disconnected are held on to and replayed
+  // once the link is back, rather than discarded
+  bool IsReplaying() const {
+    return m_policy.bEnabled && m_policy.nReplayCapacity > 0;
+  }
+
+  // Record every message this connection sends and receives to a capture
+  // log, nullptr stops recording. Must be set before the connection starts
+  void SetCapture(std::shared_ptr<capture_writer> capture) {
+    m_capture = std::move(capture);
+  }
+
 public:
   void ConnectToClient(uint32_t uid = 0) {
     if (m_nOwnerType == owner::server) {
@@ -44,23 +106,44 @@ public:
       const boost::asio::ip::tcp::resolver::results_type &endpoints) {
     // Only clients can connect to servers
     if (m_nOwnerType == owner::client) {
+      // Remember where we were going, in case we need to go there again
+      m_endpoints = endpoints;
+      m_bReconnect = m_policy.bEnabled;
+
       // Request asio attempts to connect to an endpoint
       boost::asio::async_connect(
-          m_socket, endpoints,
+          m_socket, m_endpoints,
           [this](std::error_code ec, boost::asio::ip::tcp::endpoint endpoint) {
             if (!ec) {
+              m_bConnected = true;
+              m_nReconnectAttempts = 0;
               ReadHeader();
+
+              // Anything held on to while we were away can go out now - unless
+              // a write from before the drop has yet to finish, its handler
+              // carries on with the queue
+              if (!m_qMessagesOut.empty() && !m_bWriting)
+                WriteMessage();
+            } else {
+              std::cout << "[" << id << "] Connect Fail.\n";
+              ScheduleReconnect();
             }
           });
     }
   }
 
   void Disconnect() {
-    if (IsConnected())
-      boost::asio::post(m_asioContext, [this]() { m_socket.close(); });
+    // We asked for this, so don't try and come back
+    m_bReconnect = false;
+    boost::asio::post(m_asioContext, [this]() {
+      if (m_timerReconnect)
+        m_timerReconnect->cancel();
+      if (m_socket.is_open())
+        m_socket.close();
+    });
   }
 
-  bool IsConnected() const { return m_socket.is_open(); }
+  bool IsConnected() const { return m_bConnected && m_socket.is_open(); }
 
   // Prime the connection to wait for incoming messages
   void StartListening() {}
@@ -75,84 +158,76 @@ public:
       // Either way add the message to the queue to be output. If no messages
       // were available to be written, then start the process of writing the
       // message at the front of the queue.
+      if (!m_bConnected) {
+        // No link right now - keep the message for when it comes back, if
+        // the policy allows, otherwise it is simply lost
+        if (IsReplaying()) {
+          if (m_qMessagesOut.count() >= m_policy.nReplayCapacity)
+            m_qMessagesOut.pop_front();
+          m_qMessagesOut.push_back(msg);
+        }
+        return;
+      }
+
       bool bWritingMessage = !m_qMessagesOut.empty();
       m_qMessagesOut.push_back(msg);
       if (!bWritingMessage) {
-        WriteHeader();
+        WriteMessage();
       }
     });
   }
 
 private:
-  // ASYNC - Prime context to write a message header
-  void WriteHeader() {
+  // ASYNC - Prime context to write a message
+  void WriteMessage() {
     // If this function is called, we know the outgoing message queue must have
-    // at least one message to send. So allocate a transmission buffer to hold
-    // the message, and issue the work - asio, send these bytes
-    boost::asio::async_write(m_socket,
-                             boost::asio::buffer(&m_qMessagesOut.front().header,
-                                                 sizeof(message_header<T>)),
-                             [this](std::error_code ec, std::size_t length) {
-                               // asio has now sent the bytes - if there was a
-                               // problem an error would be available...
-                               if (!ec) {
-                                 // ... no error, so check if the message header
-                                 // just sent also has a message body...
-                                 if (m_qMessagesOut.front().body.size() > 0) {
-                                   // ...it does, so issue the task to write the
-                                   // body bytes
-                                   WriteBody();
-                                 } else {
-                                   // ...it didnt, so we are done with this
-                                   // message. Remove it from the outgoing
-                                   // message queue
-                                   m_qMessagesOut.pop_front();
-
-                                   // If the queue is not empty, there are more
-                                   // messages to send, so make this happen by
-                                   // issuing the task to send the next header.
-                                   if (!m_qMessagesOut.empty()) {
-                                     WriteHeader();
-                                   }
-                                 }
-                               } else {
-                                 // ...asio failed to write the message, we
-                                 // could analyse why but for now simply assume
-                                 // the connection has died by closing the
-                                 // socket. When a future attempt to write to
-                                 // this client fails due to the closed socket,
-                                 // it will be tidied up.
-                                 std::cout << "[" << id
-                                           << "] Write Header Fail.\n";
-                                 m_socket.close();
-                               }
-                             });
-  }
+    // at least one message to send. The header and body go out together in
+    // one write - for small messages they already sit side by side in memory
+    // so it is a single buffer, otherwise asio gathers the two.
+    const message<T> &msg = m_qMessagesOut.front();
+    std::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(&msg.header, sizeof(message_header<T>)),
+        boost::asio::buffer(msg.body.data(), msg.body.size())};
+    if (msg.is_contiguous())
+      buffers = {boost::asio::buffer(&msg.header, sizeof(message_header<T>) +
+                                                      msg.body.size()),
+                 boost::asio::const_buffer()};
 
-  // ASYNC - Prime context to write a message body
-  void WriteBody() {
-    // If this function is called, a header has just been sent, and that header
-    // indicated a body existed for this message. Fill a transmission buffer
-    // with the body data, and send it!
+    m_bWriting = true;
     boost::asio::async_write(
-        m_socket,
-        boost::asio::buffer(m_qMessagesOut.front().body.data(),
-                            m_qMessagesOut.front().body.size()),
-        [this](std::error_code ec, std::size_t length) {
+        m_socket, buffers, [this](std::error_code ec, std::size_t length) {
+          m_bWriting = false;
+
+          // asio has now sent the bytes - if there was a problem an error
+          // would be available...
           if (!ec) {
-            // Sending was successful, so we are done with the message
-            // and remove it from the queue
+            // ... no error, so we are done with this message. Remove it from
+            // the outgoing message queue
+            if (m_capture)
+              m_capture->Append(id, capture_direction::outbound,
+                                m_qMessagesOut.front());
             m_qMessagesOut.pop_front();
 
-            // If the queue still has messages in it, then issue the task to
-            // send the next messages' header.
+            // The link may have dropped while this message was going out, in
+            // which case the rest of the queue waits, or goes, as the
+            // reconnect policy says
+            if (!m_bConnected) {
+              TrimOutgoing();
+              return;
+            }
+
+            // If the queue is not empty, there are more messages to send, so
+            // make this happen by issuing the task to send the next one.
             if (!m_qMessagesOut.empty()) {
-              WriteHeader();
+              WriteMessage();
             }
           } else {
-            // Sending failed, see WriteHeader() equivalent for description :P
-            std::cout << "[" << id << "] Write Body Fail.\n";
-            m_socket.close();
+            // ...asio failed to write the message, we could analyse why but
+            // for now simply assume the connection has died by closing the
+            // socket. When a future attempt to write to this client fails due
+            // to the closed socket, it will be tidied up.
+            std::cout << "[" << id << "] Write Message Fail.\n";
+            OnSocketError();
           }
         });
   }
@@ -173,9 +248,10 @@ private:
             // A complete message header has been read, check if this message
             // has a body to follow...
             if (m_msgTemporaryIn.header.size > 0) {
-              // ...it does, so allocate enough space in the messages' body
-              // vector, and issue asio with the task to read the body.
-              m_msgTemporaryIn.body.resize(m_msgTemporaryIn.header.size);
+              // ...it does, so make enough space in the messages' body,
+              // and issue asio with the task to read the body.
+              m_msgTemporaryIn.body.resize_uninitialised(
+                  m_msgTemporaryIn.header.size);
               ReadBody();
             } else {
               // it doesn't, so add this bodyless message to the connections
@@ -187,7 +263,7 @@ private:
             // has occurred. Close the socket and let the system tidy it up
             // later.
             std::cout << "[" << id << "] Read Header Fail.\n";
-            m_socket.close();
+            OnSocketError();
           }
         });
   }
@@ -210,13 +286,16 @@ private:
                               } else {
                                 // As above!
                                 std::cout << "[" << id << "] Read Body Fail.\n";
-                                m_socket.close();
+                                OnSocketError();
                               }
                             });
   }
 
   // Once a full message is received, add it to the incoming queue
   void AddToIncomingMessageQueue() {
+    if (m_capture)
+      m_capture->Append(id, capture_direction::inbound, m_msgTemporaryIn);
+
     // Shove it in queue, converting it to an "owned message", by initialising
     // with the a shared pointer from this connection object
     if (m_nOwnerType == owner::server)
@@ -230,6 +309,62 @@ private:
     ReadHeader();
   }
 
+  // An asio operation failed, so the link is gone. Close the socket, tidy up
+  // the outgoing queue and, the first time round only (a pending read and
+  // write will both fail), see if we should try again
+  void OnSocketError() {
+    m_socket.close();
+
+    bool bWasConnected = m_bConnected.exchange(false);
+
+    // A write still in flight is using the message at the front, its handler
+    // tidies up once it is done with it
+    if (!m_bWriting)
+      TrimOutgoing();
+
+    if (bWasConnected)
+      ScheduleReconnect();
+  }
+
+  // Keeps only what the reconnect policy wants replayed while there is no
+  // link. The message at the front may have been half written, it will be
+  // sent again in full should we reconnect
+  void TrimOutgoing() {
+    if (!IsReplaying())
+      m_qMessagesOut.clear();
+    else
+      while (m_qMessagesOut.count() > m_policy.nReplayCapacity)
+        m_qMessagesOut.pop_front();
+  }
+
+  // ASYNC - Prime context to have another go at connecting to the server,
+  // after waiting for however long the policy says
+  void ScheduleReconnect() {
+    if (m_nOwnerType != owner::client || !m_bReconnect)
+      return;
+
+    if (m_policy.nMaxAttempts > 0 &&
+        m_nReconnectAttempts >= m_policy.nMaxAttempts) {
+      std::cout << "[" << id << "] Reconnect Gave Up.\n";
+      return;
+    }
+
+    // Only clients that actually reconnect pay for a timer. The random
+    // engine for the jitter is shared by every connection on this thread,
+    // and seeded once
+    if (!m_timerReconnect)
+      m_timerReconnect =
+          std::make_unique<boost::asio::steady_timer>(m_asioContext);
+    thread_local std::minstd_rand rng(std::random_device{}());
+
+    m_timerReconnect->expires_after(
+        m_policy.Backoff(m_nReconnectAttempts++, rng));
+    m_timerReconnect->async_wait([this](std::error_code ec) {
+      if (!ec && m_bReconnect)
+        ConnectToServer(m_endpoints);
+    });
+  }
+
 protected:
   // Each connection has a unique socket to a remote
   boost::asio::ip::tcp::socket m_socket;
@@ -241,6 +376,10 @@ protected:
   // of this connection
   tsqueue<message<T>> m_qMessagesOut;
 
+  // True while an async_write is using the message at the front of
+  // m_qMessagesOut. Only touched by the asio thread
+  bool m_bWriting = false;
+
   // This references the incoming queue of the parent object
   tsqueue<owned_message<T>> &m_qMessagesIn;
 
@@ -252,6 +391,20 @@ protected:
   owner m_nOwnerType = owner::server;
 
   uint32_t id = 0;
+
+  // Only true once the socket is actually talking to the remote, a client
+  // socket is open while it is still connecting
+  std::atomic<bool> m_bConnected = false;
+
+  // Everything needed to find our way back to the server
+  reconnect_policy m_policy;
+  std::atomic<bool> m_bReconnect = false;
+  boost::asio::ip::tcp::resolver::results_type m_endpoints;
+  std::unique_ptr<boost::asio::steady_timer> m_timerReconnect;
+  size_t m_nReconnectAttempts = 0;
+
+  // Where to record traffic to, if anywhere
+  std::shared_ptr<capture_writer> m_capture;
 };
 } // namespace net
 } // namespace olc
\ No newline at end of file
@@ -13,13 +13,129 @@ template <typename T> struct message_header {
   uint32_t size = 0;
 };
 
-// Message Body contains a header and a std::vector, containing raw bytes
-// of infomation. This way the message can be variable length, but the size
-// in the header must be updated.
+// Bodies up to this many bytes live inside the message itself, no heap
+// allocation required. Most messages are small, so this covers the bulk of
+// traffic.
+#ifndef OLC_NET_MESSAGE_INLINE_SIZE
+#define OLC_NET_MESSAGE_INLINE_SIZE 64
+#endif
+
+// Raw bytes of a message body. Behaves like the std::vector<uint8_t> it
+// replaces, but small bodies are stored inline, and the inline storage is the
+// first thing in it - so in a message the body bytes directly follow the
+// header bytes, and both can be sent to the socket as one buffer.
+class message_body {
+public:
+  static constexpr size_t nInlineSize = OLC_NET_MESSAGE_INLINE_SIZE;
+
+public:
+  message_body() = default;
+
+  message_body(const message_body &other) { *this = other; }
+
+  message_body(message_body &&other) noexcept { *this = std::move(other); }
+
+  message_body &operator=(const message_body &other) {
+    if (this != &other) {
+      resize_uninitialised(other.m_nSize);
+      std::memcpy(data(), other.data(), m_nSize);
+    }
+    return *this;
+  }
+
+  message_body &operator=(message_body &&other) noexcept {
+    if (this != &other) {
+      if (other.m_pHeap) {
+        // Big bodies just change hands...
+        m_pHeap = std::move(other.m_pHeap);
+        m_nCapacity = other.m_nCapacity;
+        m_nSize = other.m_nSize;
+      } else {
+        // ...small ones are cheaper to copy than anything else
+        resize_uninitialised(other.m_nSize);
+        std::memcpy(data(), other.data(), m_nSize);
+      }
+      other.m_pHeap.reset();
+      other.m_nCapacity = nInlineSize;
+      other.m_nSize = 0;
+    }
+    return *this;
+  }
+
+public:
+  uint8_t *data() { return m_pHeap ? m_pHeap.get() : m_pInline; }
+  const uint8_t *data() const { return m_pHeap ? m_pHeap.get() : m_pInline; }
+
+  size_t size() const { return m_nSize; }
+  size_t capacity() const { return m_nCapacity; }
+  bool empty() const { return m_nSize == 0; }
+
+  // True while the bytes are held in the inline storage
+  bool is_inline() const { return !m_pHeap; }
+
+  uint8_t &operator[](size_t i) { return data()[i]; }
+  const uint8_t &operator[](size_t i) const { return data()[i]; }
+
+  uint8_t *begin() { return data(); }
+  uint8_t *end() { return data() + m_nSize; }
+  const uint8_t *begin() const { return data(); }
+  const uint8_t *end() const { return data() + m_nSize; }
+
+  // Makes sure n bytes fit without another allocation
+  void reserve(size_t n) {
+    if (n <= m_nCapacity)
+      return;
+
+    // No make_unique here, it would zero the block - resize() zeroes what it
+    // needs to, resize_uninitialised() is about to overwrite it anyway
+    std::unique_ptr<uint8_t[]> pHeap(new uint8_t[n]);
+    std::memcpy(pHeap.get(), data(), m_nSize);
+    m_pHeap = std::move(pHeap);
+    m_nCapacity = n;
+  }
+
+  // Like std::vector, any new bytes are zeroed
+  void resize(size_t n) {
+    size_t nOld = m_nSize;
+    resize_uninitialised(n);
+    if (n > nOld)
+      std::memset(data() + nOld, 0, n - nOld);
+  }
+
+  // Same as resize(), but leaves new bytes as they are, for when they are
+  // about to be overwritten anyway
+  void resize_uninitialised(size_t n) {
+    // Grow geometrically, so pushing lots of small things in stays cheap
+    if (n > m_nCapacity)
+      reserve(std::max(n, m_nCapacity * 2));
+    m_nSize = n;
+  }
+
+  void clear() { m_nSize = 0; }
+
+private:
+  uint8_t m_pInline[nInlineSize];
+  std::unique_ptr<uint8_t[]> m_pHeap;
+  size_t m_nCapacity = nInlineSize;
+  size_t m_nSize = 0;
+};
+
+// Message Body contains a header and a body, containing raw bytes of
+// infomation. This way the message can be variable length, but the size in
+// the header must be updated.
 template <typename T> struct message {
-  // Header & Body vector
+  // Header & Body
   message_header<T> header{};
-  std::vector<uint8_t> body;
+  message_body body;
+
+  // True if the header and the body sit next to each other in memory, so the
+  // whole framed message can be handed to the socket as one buffer. Holds for
+  // any small body, as long as no padding creeps in between the two
+  bool is_contiguous() const {
+    return body.is_inline() &&
+           reinterpret_cast<const uint8_t *>(&header) + sizeof(header) ==
+               body.data();
+  }
 
   // returns size of entire message packet in bytes
   size_t size() const { return body.size(); }
@@ -50,7 +166,7 @@ template <typename T> struct message {
     size_t i = msg.body.size();
 
     // Resize the vector by the size of the data being pushed
-    msg.body.resize(msg.body.size() + sizeof(DataType));
+    msg.body.resize_uninitialised(msg.body.size() + sizeof(DataType));
 
     // Physically copy the data into the newly allocated vector space
     std::memcpy(msg.body.data() + i, &data, sizeof(DataType));
@@ -77,7 +193,7 @@ template <typename T> struct message {
     std::memcpy(&data, msg.body.data() + i, sizeof(DataType));
 
     // Shrink the vector to remove read bytes, and reset end position
-    msg.body.resize(i);
+    msg.body.resize_uninitialised(i);
 
     // Recalculate the message size
     msg.header.size = msg.size();
@@ -3,8 +3,11 @@
 #include "net_common.hpp"
 #include "net_connection.hpp"
 #include "net_message.hpp"
+#include "net_topic.hpp"
 #include "net_tsqueue.hpp"
 
+#include <unordered_set>
+
 namespace olc {
 namespace net {
 template <typename T> class server_interface {
@@ -76,6 +79,7 @@ public:
         // Give the user server a chance to deny connection
         if (OnClientConnect(newconn)) {
           // Connection allowed, so add to container of new connections
+          newconn->SetCapture(m_capture);
           m_deqConnections.push_back(std::move(newconn));
 
           // And very important! Issue a task to the connection's
@@ -111,16 +115,20 @@ public:
     } else {
       // If we cant communicate with client then we may as
       // well remove the client - let the server know, it may
-      // be tracking it somehow
-      OnClientDisconnect(client);
+      // be tracking it somehow - unless Publish() already has
+      ReportDisconnect(client);
 
-      // Off you go now, bye bye!
-      client.reset();
+      // It won't be needing its subscriptions any more
+      m_topics.remove(client);
 
-      // Then physically remove it from the container
+      // Physically remove it from the container, while we still know which
+      // one it is, so it is never reported as disconnected again
       m_deqConnections.erase(
           std::remove(m_deqConnections.begin(), m_deqConnections.end(), client),
           m_deqConnections.end());
+
+      // Off you go now, bye bye!
+      client.reset();
     }
   }
 
@@ -140,7 +148,8 @@ public:
       } else {
         // The client couldnt be contacted, so assume it has
         // disconnected.
-        OnClientDisconnect(client);
+        ReportDisconnect(client);
+        m_topics.remove(client);
         client.reset();
 
         // Set this flag to then remove dead clients from container
@@ -156,6 +165,73 @@ public:
                              m_deqConnections.end());
   }
 
+  // Record all traffic of connections accepted from now on to a capture log,
+  // nullptr stops recording new connections
+  void SetCapture(std::shared_ptr<capture_writer> capture) {
+    m_capture = std::move(capture);
+  }
+
+  // Subscribe a client to a topic, returns false if it already was
+  bool Subscribe(std::shared_ptr<connection<T>> client, uint32_t nTopic) {
+    return client && m_topics.subscribe(nTopic, client);
+  }
+
+  // Unsubscribe a client from a topic, returns false if it wasn't subscribed
+  bool Unsubscribe(std::shared_ptr<connection<T>> client, uint32_t nTopic) {
+    return client && m_topics.unsubscribe(nTopic, client);
+  }
+
+  // Let clients manage their own subscriptions. A message with idSubscribe or
+  // idUnsubscribe carrying a uint32_t topic (pushed with operator<<) is dealt
+  // with by Update() and never reaches OnMessage()
+  void SetTopicControlIds(T idSubscribe, T idUnsubscribe) {
+    m_idSubscribe = idSubscribe;
+    m_idUnsubscribe = idUnsubscribe;
+  }
+
+  // Number of clients subscribed to a topic
+  size_t SubscriberCount(uint32_t nTopic) const {
+    return m_topics.count(nTopic);
+  }
+
+  // Send message to every client subscribed to a topic. Only the subscribers
+  // are visited, however many other clients are connected
+  void Publish(uint32_t nTopic, const message<T> &msg,
+               std::shared_ptr<connection<T>> pIgnoreClient = nullptr) {
+    auto subscribers = m_topics.subscribers(nTopic);
+    if (!subscribers)
+      return;
+
+    std::vector<std::shared_ptr<connection<T>>> vDeadClients;
+    for (auto &client : *subscribers) {
+      if (client->IsConnected()) {
+        if (client != pIgnoreClient)
+          client->Send(msg);
+      } else {
+        // Can't modify the topic while walking it, so deal with these after
+        vDeadClients.push_back(client);
+      }
+    }
+
+    // Let the server know and drop their subscriptions, but leave them in
+    // m_deqConnections - finding them there means walking every connection,
+    // which is exactly what publishing to a topic avoids. MessageClient() or
+    // MessageAllClients() tidy them away later, without reporting them twice
+    for (auto &client : vDeadClients) {
+      ReportDisconnect(client);
+      m_topics.remove(client);
+      m_setReportedClients.insert(client.get());
+    }
+  }
+
+  // Choose how Update(..., true) waits for messages to arrive, see
+  // wait_strategy
+  void SetWaitStrategy(
+      wait_strategy strategy,
+      std::chrono::nanoseconds maxSpin = std::chrono::microseconds(50)) {
+    m_qMessagesIn.set_wait_strategy(strategy, maxSpin);
+  }
+
   // Force server to respond to incoming messages
   void Update(size_t nMaxMessages = -1, bool bWait = false) {
     if (bWait)
@@ -168,13 +244,41 @@ public:
       // Grab the front message
       auto msg = m_qMessagesIn.pop_front();
 
-      // Pass to message handler
-      OnMessage(msg.remote, msg.msg);
+      // Subscription requests are handled here, everything else is passed to
+      // the message handler
+      if (!HandleTopicControl(msg))
+        OnMessage(msg.remote, msg.msg);
 
       nMessageCount++;
     }
   }
 
+private:
+  // Tells the server a client has gone, once - a client Publish() found dead
+  // is still in m_deqConnections, and will be found again when it is pruned
+  void ReportDisconnect(const std::shared_ptr<connection<T>> &client) {
+    if (m_setReportedClients.erase(client.get()) == 0)
+      OnClientDisconnect(client);
+  }
+
+  // Returns true if msg was a subscription request, and acts on it
+  bool HandleTopicControl(owned_message<T> &msg) {
+    if (!m_idSubscribe || msg.msg.body.size() < sizeof(uint32_t))
+      return false;
+
+    bool bSubscribe = msg.msg.header.id == *m_idSubscribe;
+    if (!bSubscribe && msg.msg.header.id != *m_idUnsubscribe)
+      return false;
+
+    uint32_t nTopic = 0;
+    msg.msg >> nTopic;
+    if (bSubscribe)
+      Subscribe(msg.remote, nTopic);
+    else
+      Unsubscribe(msg.remote, nTopic);
+    return true;
+  }
+
 protected:
   // This server class should override thse functions to implement
   // customised functionality
@@ -209,6 +313,20 @@ protected:
 
   // Clients will be identified in the "wider system" via an ID
   uint32_t nIDCounter = 10000;
+
+  // Which clients are subscribed to which topics
+  topic_index<T> m_topics;
+
+  // Dead clients Publish() has already reported, that are still waiting to
+  // be pruned from m_deqConnections
+  std::unordered_set<connection<T> *> m_setReportedClients;
+
+  // Message ids clients use to (un)subscribe, if the server allows it
+  std::optional<T> m_idSubscribe;
+  std::optional<T> m_idUnsubscribe;
+
+  // Where new connections record their traffic to, if anywhere
+  std::shared_ptr<capture_writer> m_capture;
 };
 } // namespace net
 } // namespace olc
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "net_common.hpp"
+#include "net_message.hpp"
+
+#include <unordered_map>
+
+namespace olc {
+namespace net {
+// Maps topics to the connections subscribed to them, and back again. Each
+// topic keeps its subscribers packed together in a vector, so publishing only
+// walks the connections that actually care. Subscribing and unsubscribing are
+// constant time - the removed subscriber's slot is filled by the last one.
+//
+// NOTE: Not thread safe, the server only touches it from the thread that
+// calls Update()
+template <typename T> class topic_index {
+public:
+  using subscriber_list = std::vector<std::shared_ptr<connection<T>>>;
+
+public:
+  // Adds client to topic, returns false if it was already subscribed
+  bool subscribe(uint32_t nTopic,
+                 const std::shared_ptr<connection<T>> &client) {
+    auto &topic = mapTopics[nTopic];
+    if (!topic.mapSlot.emplace(client.get(), topic.vSubscribers.size()).second)
+      return false;
+
+    topic.vSubscribers.push_back(client);
+    mapClientTopics[client.get()].push_back(nTopic);
+    return true;
+  }
+
+  // Removes client from topic, returns false if it wasn't subscribed
+  bool unsubscribe(uint32_t nTopic,
+                   const std::shared_ptr<connection<T>> &client) {
+    if (!remove_from_topic(nTopic, client.get()))
+      return false;
+
+    auto it = mapClientTopics.find(client.get());
+    auto &vTopics = it->second;
+    vTopics.erase(std::find(vTopics.begin(), vTopics.end(), nTopic));
+    if (vTopics.empty())
+      mapClientTopics.erase(it);
+    return true;
+  }
+
+  // Removes client from every topic it is subscribed to
+  void remove(const std::shared_ptr<connection<T>> &client) {
+    auto it = mapClientTopics.find(client.get());
+    if (it == mapClientTopics.end())
+      return;
+
+    for (uint32_t nTopic : it->second)
+      remove_from_topic(nTopic, client.get());
+    mapClientTopics.erase(it);
+  }
+
+  // Returns the subscribers of a topic, or nullptr if it has none
+  const subscriber_list *subscribers(uint32_t nTopic) const {
+    auto it = mapTopics.find(nTopic);
+    return it == mapTopics.end() ? nullptr : &it->second.vSubscribers;
+  }
+
+  // Returns number of subscribers to a topic
+  size_t count(uint32_t nTopic) const {
+    auto list = subscribers(nTopic);
+    return list ? list->size() : 0;
+  }
+
+  // Forgets every subscription
+  void clear() {
+    mapTopics.clear();
+    mapClientTopics.clear();
+  }
+
+private:
+  bool remove_from_topic(uint32_t nTopic, connection<T> *client) {
+    auto itTopic = mapTopics.find(nTopic);
+    if (itTopic == mapTopics.end())
+      return false;
+
+    auto &topic = itTopic->second;
+    auto itSlot = topic.mapSlot.find(client);
+    if (itSlot == topic.mapSlot.end())
+      return false;
+
+    // Move the last subscriber into the hole, and update where it lives
+    size_t nSlot = itSlot->second;
+    topic.mapSlot.erase(itSlot);
+    if (nSlot != topic.vSubscribers.size() - 1) {
+      topic.vSubscribers[nSlot] = std::move(topic.vSubscribers.back());
+      topic.mapSlot[topic.vSubscribers[nSlot].get()] = nSlot;
+    }
+    topic.vSubscribers.pop_back();
+
+    // Empty topics are not worth keeping around
+    if (topic.vSubscribers.empty())
+      mapTopics.erase(itTopic);
+    return true;
+  }
+
+private:
+  struct topic {
+    subscriber_list vSubscribers;
+    std::unordered_map<connection<T> *, size_t> mapSlot;
+  };
+
+  // Topic -> its subscribers, and client -> the topics it is subscribed to
+  std::unordered_map<uint32_t, topic> mapTopics;
+  std::unordered_map<connection<T> *, std::vector<uint32_t>> mapClientTopics;
+};
+} // namespace net
+} // namespace olc
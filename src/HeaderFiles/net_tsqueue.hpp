@@ -2,8 +2,36 @@
 
 #include "net_common.hpp"
 
+#include <condition_variable>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace olc {
 namespace net {
+// How a consumer waits for something to arrive in a tsqueue
+enum class wait_strategy {
+  // Sleep on a condition variable until a producer wakes us - cheap on the
+  // CPU, but waking up costs microseconds
+  park,
+  // Keep checking for a while before going to sleep. How long is adapted to
+  // how often spinning actually pays off
+  spin_then_park,
+  // Never sleep, keep checking - lowest latency, but burns the whole core,
+  // only sensible for consumers with a core of their own
+  busy_poll
+};
+
+// Tell the CPU we are spinning, so it can ease off a little
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
 template <typename T> class tsqueue {
 public:
   tsqueue() = default;
@@ -28,6 +56,7 @@ public:
     std::scoped_lock lock(muxQueue);
     auto t = std::move(deqQueue.front());
     deqQueue.pop_front();
+    nItems--;
     return t;
   }
 
@@ -36,25 +65,30 @@ public:
     std::scoped_lock lock(muxQueue);
     auto t = std::move(deqQueue.back());
     deqQueue.pop_back();
+    nItems--;
     return t;
   }
 
   // Adds an item to back of Queue
   void push_back(const T &item) {
-    std::scoped_lock lock(muxQueue);
-    deqQueue.emplace_back(std::move(item));
+    {
+      std::scoped_lock lock(muxQueue);
+      deqQueue.emplace_back(std::move(item));
+      nItems++;
+    }
 
-    std::unique_lock<std::mutex> ul(muxBlocking);
-    cvBlocking.notify_one();
+    notify();
   }
 
   // Adds an item to front of Queue
   void push_front(const T &item) {
-    std::scoped_lock lock(muxQueue);
-    deqQueue.emplace_front(std::move(item));
+    {
+      std::scoped_lock lock(muxQueue);
+      deqQueue.emplace_front(std::move(item));
+      nItems++;
+    }
 
-    std::unique_lock<std::mutex> ul(muxBlocking);
-    cvBlocking.notify_one();
+    notify();
   }
 
   // Returns true if Queue has no items
@@ -73,12 +107,80 @@ public:
   void clear() {
     std::scoped_lock lock(muxQueue);
     deqQueue.clear();
+    nItems = 0;
   }
 
+  // Choose how wait() waits. For spin_then_park, maxSpin caps how long a
+  // consumer spins before it parks
+  void set_wait_strategy(
+      wait_strategy strategy,
+      std::chrono::nanoseconds maxSpin = std::chrono::microseconds(50)) {
+    waitStrategy = strategy;
+    nMaxSpinNs = std::max<int64_t>(maxSpin.count(), nMinSpinNs);
+    nSpinNs = nMaxSpinNs.load();
+  }
+
+  // Blocks until the Queue has at least one item in it
   void wait() {
-    while (empty()) {
+    switch (waitStrategy.load()) {
+    case wait_strategy::busy_poll:
+      while (nItems == 0)
+        cpu_relax();
+      return;
+
+    case wait_strategy::spin_then_park: {
+      // Spinning paid off, so be willing to spin a little longer next time,
+      // if it didn't, spin less and go straight to sleep sooner
+      int64_t nBudget = nSpinNs;
+      if (spin(std::chrono::nanoseconds(nBudget))) {
+        nSpinNs = std::min<int64_t>(nBudget * 2, nMaxSpinNs);
+        return;
+      }
+      nSpinNs = std::max<int64_t>(nBudget / 2, nMinSpinNs);
+      park();
+      return;
+    }
+
+    case wait_strategy::park:
+      park();
+      return;
+    }
+  }
+
+private:
+  // Checks for items until one arrives or the time is up, returns true if
+  // one arrived
+  bool spin(std::chrono::nanoseconds budget) {
+    auto tpEnd = std::chrono::steady_clock::now() + budget;
+    while (nItems == 0) {
+      // Reading the clock costs more than a pause, so don't do it every time
+      for (int i = 0; i < 64; i++) {
+        cpu_relax();
+        if (nItems > 0)
+          return true;
+      }
+      if (std::chrono::steady_clock::now() >= tpEnd)
+        return false;
+    }
+    return true;
+  }
+
+  // Sleeps until a producer wakes us. We announce ourselves in nParked before
+  // the final check for items, and producers check nParked after adding one,
+  // so at least one side always sees the other and no wake up is lost
+  void park() {
+    std::unique_lock<std::mutex> ul(muxBlocking);
+    nParked++;
+    cvBlocking.wait(ul, [this]() { return nItems > 0; });
+    nParked--;
+  }
+
+  // Wakes a parked consumer - producers don't touch muxBlocking at all when
+  // nobody is parked
+  void notify() {
+    if (nParked > 0) {
       std::unique_lock<std::mutex> ul(muxBlocking);
-      cvBlocking.wait(ul);
+      cvBlocking.notify_one();
     }
   }
 
@@ -87,6 +189,17 @@ protected:
   std::deque<T> deqQueue;
   std::condition_variable cvBlocking;
   std::mutex muxBlocking;
+
+  // Mirrors deqQueue.size(), so waiting consumers can check it without
+  // fighting producers for muxQueue
+  std::atomic<size_t> nItems = 0;
+  // Number of consumers asleep on cvBlocking
+  std::atomic<size_t> nParked = 0;
+
+  std::atomic<wait_strategy> waitStrategy = wait_strategy::park;
+  static constexpr int64_t nMinSpinNs = 1000;
+  std::atomic<int64_t> nMaxSpinNs = 50000;
+  std::atomic<int64_t> nSpinNs = 50000;
 };
 } // namespace net
 } // namespace olc
\ No newline at end of file
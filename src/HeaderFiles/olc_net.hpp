@@ -1,8 +1,11 @@
 #pragma once
 
+#include "net_capture.hpp"
 #include "net_client.hpp"
+#include "net_client_pool.hpp"
 #include "net_common.hpp"
 #include "net_connection.hpp"
 #include "net_message.hpp"
 #include "net_server.hpp"
+#include "net_topic.hpp"
 #include "net_tsqueue.hpp"
\ No newline at end of file
@@ -0,0 +1,672 @@
+// Connection-scale load generator, for soak testing a server_interface with
+// tens of thousands of concurrent clients on one Linux box over loopback.
+//
+// Rather than a client_interface per client (each with its own io_context and
+// thread), thousands of simulated clients share a handful of io_contexts.
+// Every client runs a closed loop: send a message, wait for the echo, think,
+// repeat - and, with churn enabled, hang up and reconnect now and then.
+//
+// Usage:
+//   net_loadgen serve <port>
+//       Runs an echo server built on server_interface to aim at
+//   net_loadgen run <host> <port> [options]
+//       --clients n     concurrent clients to ramp up to (default 1000)
+//       --rate n        new connections per second while ramping (1000)
+//       --threads n     io_contexts/threads the clients are spread over (2)
+//       --mix s:w,...   body sizes and their weights (16:80,256:15,4096:5)
+//       --think ms      mean think time between messages, 0 = none (100)
+//       --churn s       mean connection lifetime in seconds, 0 = forever (0)
+//       --duration s    how long to run for (60)
+//       --interval s    how often to report (1)
+//       --server-pid p  report the server's memory per connection
+//       --id n          message id the server echoes back (0)
+//       --source-addrs n  spread the clients' own addresses over 127.0.0.1
+//                         to 127.0.0.n, 0 = leave it to the kernel (0)
+//
+// The server must echo every message back unchanged, as "serve" does. The
+// first 8 bytes of each body carry the send time, which is how round trips
+// are timed.
+//
+// Every connection from one source address to the server's address and port
+// needs a local port of its own, and Linux only hands those out from
+// net.ipv4.ip_local_port_range - 32768 to 60999 by default, about 28k. Past
+// that, connects fail with EADDRNOTAVAIL. With the server on loopback,
+// --source-addrs lifts the ceiling to roughly 28k clients per address, so
+// 100k clients need --source-addrs 4 or more.
+
+#include "olc_net.hpp"
+
+#include <fstream>
+#include <future>
+#include <map>
+#include <sstream>
+
+#include <sys/resource.h>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+enum class loadgen_msg : uint32_t { Echo };
+
+using header_type = olc::net::message_header<loadgen_msg>;
+
+uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             clock_type::now().time_since_epoch())
+      .count();
+}
+
+// Every socket is a file descriptor, so the default limit of 1024 won't get
+// us far - go as high as we are allowed
+void RaiseFileLimit() {
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+// Resident memory of a process in bytes, 0 if it can't be read
+size_t ResidentBytes(int nPid) {
+  std::ifstream file("/proc/" + std::to_string(nPid) + "/status");
+  std::string sLine;
+  while (std::getline(file, sLine))
+    if (sLine.rfind("VmRSS:", 0) == 0)
+      return std::stoull(sLine.substr(6)) * 1024;
+  return 0;
+}
+
+// Records latencies in nanoseconds. Buckets double in width, each split into
+// 32 linear steps, so percentiles are accurate to about 3% at any scale
+class latency_histogram {
+public:
+  void record(uint64_t nValue) {
+    vCounts[index(nValue)]++;
+    nCount++;
+  }
+
+  void merge(const latency_histogram &other) {
+    for (size_t i = 0; i < vCounts.size(); i++)
+      vCounts[i] += other.vCounts[i];
+    nCount += other.nCount;
+  }
+
+  // Value below which fPercentile percent of recorded values fall
+  uint64_t percentile(double fPercentile) const {
+    if (nCount == 0)
+      return 0;
+
+    uint64_t nTarget = std::max<uint64_t>(
+        1, uint64_t(std::ceil(double(nCount) * fPercentile / 100.0)));
+    uint64_t nSeen = 0;
+    for (size_t i = 0; i < vCounts.size(); i++) {
+      nSeen += vCounts[i];
+      if (nSeen >= nTarget)
+        return value(i);
+    }
+    return value(vCounts.size() - 1);
+  }
+
+  uint64_t count() const { return nCount; }
+
+private:
+  static constexpr int nSubBits = 5;
+  static constexpr uint64_t nSubCount = 1 << nSubBits;
+
+  static size_t index(uint64_t nValue) {
+    if (nValue < nSubCount)
+      return size_t(nValue);
+    int nShift = 63 - __builtin_clzll(nValue) - nSubBits;
+    return size_t((nShift + 1) << nSubBits) +
+           size_t((nValue >> nShift) & (nSubCount - 1));
+  }
+
+  static uint64_t value(size_t nIndex) {
+    if (nIndex < nSubCount)
+      return nIndex;
+    int nShift = int(nIndex >> nSubBits) - 1;
+    return (nSubCount + (nIndex & (nSubCount - 1))) << nShift;
+  }
+
+  std::array<uint64_t, 64 << nSubBits> vCounts{};
+  uint64_t nCount = 0;
+};
+
+// What happened during one reporting interval
+struct interval_stats {
+  latency_histogram histConnect;  // connect() until the socket is connected
+  latency_histogram histFirst;    // connect() until the first echo arrives
+  latency_histogram histRoundTrip; // every message, send until echo
+  uint64_t nConnects = 0;
+  uint64_t nConnectFails = 0;
+  uint64_t nDrops = 0;
+  uint64_t nMessages = 0;
+
+  void merge(const interval_stats &other) {
+    histConnect.merge(other.histConnect);
+    histFirst.merge(other.histFirst);
+    histRoundTrip.merge(other.histRoundTrip);
+    nConnects += other.nConnects;
+    nConnectFails += other.nConnectFails;
+    nDrops += other.nDrops;
+    nMessages += other.nMessages;
+  }
+};
+
+struct loadgen_options {
+  std::string sHost;
+  std::string sPort;
+  size_t nClients = 1000;
+  double fRate = 1000;
+  size_t nThreads = 2;
+  std::vector<std::pair<uint32_t, double>> vMix = {
+      {16, 80}, {256, 15}, {4096, 5}};
+  double fThinkMs = 100;
+  double fChurnSeconds = 0;
+  double fDurationSeconds = 60;
+  double fIntervalSeconds = 1;
+  int nServerPid = 0;
+  uint32_t nMessageId = 0;
+  size_t nSourceAddrs = 0;
+};
+
+class sim_client;
+
+// One io_context, its thread, and the clients that live on it. Everything in
+// here apart from the context is only touched from its own thread
+struct worker {
+  worker(const loadgen_options &options,
+         const boost::asio::ip::tcp::resolver::results_type &endpoints,
+         uint64_t nSeed)
+      : options(options), endpoints(endpoints), rng(nSeed) {
+    std::vector<double> vWeights;
+    for (auto &[nSize, fWeight] : options.vMix)
+      vWeights.push_back(fWeight);
+    distSize = std::discrete_distribution<size_t>(vWeights.begin(),
+                                                  vWeights.end());
+  }
+
+  const loadgen_options &options;
+  boost::asio::ip::tcp::resolver::results_type endpoints;
+
+  boost::asio::io_context context;
+  std::thread thr;
+
+  std::vector<std::unique_ptr<sim_client>> vClients;
+  size_t nConnected = 0;
+  interval_stats stats;
+
+  std::mt19937_64 rng;
+  std::discrete_distribution<size_t> distSize;
+
+  // Exponentially distributed delay with the given mean
+  std::chrono::nanoseconds RandomDelay(double fMeanSeconds) {
+    if (fMeanSeconds <= 0)
+      return std::chrono::nanoseconds(0);
+    std::exponential_distribution<double> dist(1.0 / fMeanSeconds);
+    return std::chrono::nanoseconds(int64_t(dist(rng) * 1e9));
+  }
+};
+
+// A simulated client - connects, then sends, waits for the echo and thinks,
+// over and over. If its lifetime runs out it hangs up and starts again.
+class sim_client {
+public:
+  sim_client(worker &w, std::optional<boost::asio::ip::address> source)
+      : m_worker(w), m_socket(w.context), m_timer(w.context),
+        m_source(source) {}
+
+  void Connect() {
+    m_nConnectStart = NowNs();
+    m_bFirstEcho = true;
+    m_tpExpire = clock_type::time_point::max();
+    if (m_worker.options.fChurnSeconds > 0)
+      m_tpExpire = clock_type::now() +
+                   m_worker.RandomDelay(m_worker.options.fChurnSeconds);
+
+    if (!m_source) {
+      boost::asio::async_connect(
+          m_socket, m_worker.endpoints,
+          [this](std::error_code ec, boost::asio::ip::tcp::endpoint endpoint) {
+            OnConnect(ec);
+          });
+      return;
+    }
+
+    // Bind to our own source address first. Connecting to a range of
+    // endpoints would close the socket between attempts and lose the
+    // binding, so only the first endpoint is tried
+    boost::asio::ip::tcp::endpoint endpoint = *m_worker.endpoints.begin();
+    boost::system::error_code ec;
+    m_socket.open(endpoint.protocol(), ec);
+#ifdef IP_BIND_ADDRESS_NO_PORT
+    // Leave picking the local port until connect time, so it only has to be
+    // unique for this address and the server's, not for the address alone
+    if (!ec)
+      m_socket.set_option(boost::asio::detail::socket_option::boolean<
+                              IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT>(true),
+                          ec);
+#endif
+    if (!ec)
+      m_socket.bind(boost::asio::ip::tcp::endpoint(*m_source, 0), ec);
+    if (ec) {
+      OnConnect(ec);
+      return;
+    }
+    m_socket.async_connect(endpoint,
+                           [this](std::error_code ec) { OnConnect(ec); });
+  }
+
+  void Close() {
+    if (m_bConnected) {
+      m_bConnected = false;
+      m_worker.nConnected--;
+    }
+    m_timer.cancel();
+    m_socket.close();
+  }
+
+private:
+  void OnConnect(std::error_code ec) {
+    if (!ec) {
+      m_worker.stats.nConnects++;
+      m_worker.stats.histConnect.record(NowNs() - m_nConnectStart);
+      m_worker.nConnected++;
+      m_bConnected = true;
+
+      m_socket.set_option(boost::asio::ip::tcp::no_delay(true));
+      Send();
+    } else {
+      // Back off a little before trying again, the server is most likely
+      // struggling to keep up. A failed connect can leave the socket open,
+      // and the next attempt needs to open it afresh
+      m_worker.stats.nConnectFails++;
+      boost::system::error_code ecClose;
+      m_socket.close(ecClose);
+      Wait(std::chrono::milliseconds(100), [this]() { Connect(); });
+    }
+  }
+
+  // ASYNC - Send one message of a size picked from the mix
+  void Send() {
+    uint32_t nSize = std::max<uint32_t>(
+        m_worker.options.vMix[m_worker.distSize(m_worker.rng)].first,
+        sizeof(uint64_t));
+
+    header_type header;
+    header.id = loadgen_msg(m_worker.options.nMessageId);
+    header.size = nSize;
+
+    // Header and body go out as one buffer, the body starts with the time
+    m_vOut.assign(sizeof(header) + nSize, 0);
+    uint64_t nSent = NowNs();
+    std::memcpy(m_vOut.data(), &header, sizeof(header));
+    std::memcpy(m_vOut.data() + sizeof(header), &nSent, sizeof(nSent));
+
+    boost::asio::async_write(m_socket, boost::asio::buffer(m_vOut),
+                             [this](std::error_code ec, std::size_t length) {
+                               if (!ec)
+                                 ReadHeader();
+                               else
+                                 Drop();
+                             });
+  }
+
+  // ASYNC - Wait for the echo's header...
+  void ReadHeader() {
+    boost::asio::async_read(
+        m_socket, boost::asio::buffer(&m_headerIn, sizeof(m_headerIn)),
+        [this](std::error_code ec, std::size_t length) {
+          if (!ec) {
+            m_vIn.resize(m_headerIn.size);
+            ReadBody();
+          } else {
+            Drop();
+          }
+        });
+  }
+
+  // ASYNC - ...and its body, which tells us when it was sent
+  void ReadBody() {
+    boost::asio::async_read(
+        m_socket, boost::asio::buffer(m_vIn),
+        [this](std::error_code ec, std::size_t length) {
+          if (ec) {
+            Drop();
+            return;
+          }
+
+          uint64_t nNow = NowNs();
+          if (m_vIn.size() >= sizeof(uint64_t)) {
+            uint64_t nSent = 0;
+            std::memcpy(&nSent, m_vIn.data(), sizeof(nSent));
+            m_worker.stats.histRoundTrip.record(nNow - nSent);
+          }
+          if (m_bFirstEcho) {
+            m_worker.stats.histFirst.record(nNow - m_nConnectStart);
+            m_bFirstEcho = false;
+          }
+          m_worker.stats.nMessages++;
+
+          Wait(m_worker.RandomDelay(m_worker.options.fThinkMs / 1000.0),
+               [this]() {
+                 // Time to go? Hang up and come back as a "new" client
+                 if (clock_type::now() >= m_tpExpire) {
+                   Close();
+                   Connect();
+                 } else {
+                   Send();
+                 }
+               });
+        });
+  }
+
+  // The server hung up on us, or something broke - start over
+  void Drop() {
+    if (!m_bConnected)
+      return;
+    m_worker.stats.nDrops++;
+    Close();
+    Connect();
+  }
+
+  template <typename Func>
+  void Wait(std::chrono::nanoseconds delay, Func fn) {
+    if (delay.count() == 0) {
+      fn();
+      return;
+    }
+    m_timer.expires_after(delay);
+    m_timer.async_wait([fn](std::error_code ec) {
+      if (!ec)
+        fn();
+    });
+  }
+
+private:
+  worker &m_worker;
+  boost::asio::ip::tcp::socket m_socket;
+  boost::asio::steady_timer m_timer;
+  std::optional<boost::asio::ip::address> m_source;
+
+  std::vector<uint8_t> m_vOut;
+  header_type m_headerIn;
+  std::vector<uint8_t> m_vIn;
+
+  uint64_t m_nConnectStart = 0;
+  bool m_bConnected = false;
+  bool m_bFirstEcho = true;
+  clock_type::time_point m_tpExpire;
+};
+
+// The server for "serve" - echoes whatever it is sent
+class echo_server : public olc::net::server_interface<loadgen_msg> {
+public:
+  echo_server(uint16_t nPort)
+      : olc::net::server_interface<loadgen_msg>(nPort),
+        m_timerSweep(m_asioContext) {}
+
+  // An echo server only ever replies to whoever spoke, so nothing in
+  // server_interface notices clients that have gone away - without this,
+  // every churned connection would stay allocated and the memory per
+  // connection figures would be measuring that instead.
+  void StartSweeping() {
+    m_timerSweep.expires_after(std::chrono::milliseconds(100));
+    m_timerSweep.async_wait([this](std::error_code ec) {
+      if (!ec) {
+        RemoveDeadClients();
+        StartSweeping();
+      }
+    });
+  }
+
+private:
+  // ASYNC - runs on the asio thread, the only other place m_deqConnections
+  // is touched here is the accept handler, which runs there too. Topics are
+  // left alone - they belong to the Update() thread, and nobody subscribes
+  // to anything here anyway
+  void RemoveDeadClients() {
+    bool bInvalidClientExists = false;
+    for (auto &client : m_deqConnections) {
+      if (client && !client->IsConnected()) {
+        OnClientDisconnect(client);
+        client.reset();
+        bInvalidClientExists = true;
+      }
+    }
+
+    if (bInvalidClientExists)
+      m_deqConnections.erase(std::remove(m_deqConnections.begin(),
+                                         m_deqConnections.end(), nullptr),
+                             m_deqConnections.end());
+  }
+
+  boost::asio::steady_timer m_timerSweep;
+
+protected:
+  bool OnClientConnect(
+      std::shared_ptr<olc::net::connection<loadgen_msg>> client) override {
+    return true;
+  }
+
+  void OnMessage(std::shared_ptr<olc::net::connection<loadgen_msg>> client,
+                 olc::net::message<loadgen_msg> &msg) override {
+    client->Send(msg);
+  }
+};
+
+int Serve(uint16_t nPort) {
+  RaiseFileLimit();
+  echo_server server(nPort);
+  if (!server.Start())
+    return 1;
+  server.StartSweeping();
+
+  while (true)
+    server.Update(-1, true);
+}
+
+std::string Micros(uint64_t nNs) {
+  std::ostringstream ss;
+  ss.precision(1);
+  ss << std::fixed << double(nNs) / 1000.0;
+  return ss.str();
+}
+
+int Run(const loadgen_options &options) {
+  RaiseFileLimit();
+
+  boost::asio::io_context resolverContext;
+  boost::asio::ip::tcp::resolver resolver(resolverContext);
+  auto endpoints = resolver.resolve(options.sHost, options.sPort);
+
+  // 127.0.0.x can only reach a server that is on loopback too
+  if (options.nSourceAddrs > 0) {
+    auto address = endpoints.begin()->endpoint().address();
+    if (!address.is_v4() || !address.is_loopback())
+      throw std::runtime_error("--source-addrs needs an IPv4 loopback host");
+    if (options.nSourceAddrs > 0xFFFFFE)
+      throw std::runtime_error("--source-addrs is limited to 127.0.0.0/8");
+  }
+
+  size_t nServerBaseline =
+      options.nServerPid ? ResidentBytes(options.nServerPid) : 0;
+
+  // Spin up the workers, each one keeps running until we say stop
+  std::vector<std::unique_ptr<worker>> vWorkers;
+  std::vector<boost::asio::executor_work_guard<
+      boost::asio::io_context::executor_type>>
+      vWork;
+  std::random_device rd;
+  for (size_t i = 0; i < std::max<size_t>(options.nThreads, 1); i++) {
+    vWorkers.push_back(std::make_unique<worker>(options, endpoints, rd()));
+    vWork.push_back(boost::asio::make_work_guard(vWorkers.back()->context));
+    auto &w = *vWorkers.back();
+    w.thr = std::thread([&w]() { w.context.run(); });
+  }
+
+  std::cout << "time(s) clients connects/s fails drops msgs/s"
+               " connect_p50/p99(us) first_p50/p99(us)"
+               " rtt_p50/p99/p999(us)"
+            << (options.nServerPid ? " server_rss(MB) bytes/conn" : "")
+            << "\n";
+
+  auto tpStart = clock_type::now();
+  auto tpReport = tpStart;
+  size_t nLaunched = 0;
+
+  while (true) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto tpNow = clock_type::now();
+    double fElapsed = std::chrono::duration<double>(tpNow - tpStart).count();
+    if (fElapsed >= options.fDurationSeconds)
+      break;
+
+    // Ramp up - launch however many clients are due by now
+    size_t nDue = std::min(options.nClients, size_t(fElapsed * options.fRate));
+    for (; nLaunched < nDue; nLaunched++) {
+      auto &w = *vWorkers[nLaunched % vWorkers.size()];
+      std::optional<boost::asio::ip::address> source;
+      if (options.nSourceAddrs > 0)
+        source = boost::asio::ip::address_v4(
+            0x7F000001 + uint32_t(nLaunched % options.nSourceAddrs));
+      boost::asio::post(w.context, [&w, source]() {
+        w.vClients.push_back(std::make_unique<sim_client>(w, source));
+        w.vClients.back()->Connect();
+      });
+    }
+
+    if (std::chrono::duration<double>(tpNow - tpReport).count() <
+        options.fIntervalSeconds)
+      continue;
+
+    // Collect what each worker saw since last time, from its own thread
+    std::vector<std::future<std::pair<interval_stats, size_t>>> vFutures;
+    for (auto &w : vWorkers) {
+      auto promise =
+          std::make_shared<std::promise<std::pair<interval_stats, size_t>>>();
+      vFutures.push_back(promise->get_future());
+      boost::asio::post(w->context, [promise, pw = w.get()]() {
+        promise->set_value({std::exchange(pw->stats, interval_stats()),
+                            pw->nConnected});
+      });
+    }
+
+    interval_stats stats;
+    size_t nConnected = 0;
+    for (auto &f : vFutures) {
+      auto [s, n] = f.get();
+      stats.merge(s);
+      nConnected += n;
+    }
+
+    double fInterval =
+        std::chrono::duration<double>(clock_type::now() - tpReport).count();
+    tpReport = clock_type::now();
+
+    std::cout << std::fixed;
+    std::cout.precision(1);
+    std::cout << fElapsed << " " << nConnected << " "
+              << uint64_t(double(stats.nConnects) / fInterval) << " "
+              << stats.nConnectFails << " " << stats.nDrops << " "
+              << uint64_t(double(stats.nMessages) / fInterval) << " "
+              << Micros(stats.histConnect.percentile(50)) << "/"
+              << Micros(stats.histConnect.percentile(99)) << " "
+              << Micros(stats.histFirst.percentile(50)) << "/"
+              << Micros(stats.histFirst.percentile(99)) << " "
+              << Micros(stats.histRoundTrip.percentile(50)) << "/"
+              << Micros(stats.histRoundTrip.percentile(99)) << "/"
+              << Micros(stats.histRoundTrip.percentile(99.9));
+    if (options.nServerPid) {
+      size_t nRss = ResidentBytes(options.nServerPid);
+      std::cout << " " << double(nRss) / (1024.0 * 1024.0) << " "
+                << (nConnected && nRss > nServerBaseline
+                        ? (nRss - nServerBaseline) / nConnected
+                        : 0);
+    }
+    std::cout << std::endl;
+  }
+
+  // Hang up everyone, then let the workers go
+  for (auto &w : vWorkers)
+    boost::asio::post(w->context, [pw = w.get()]() {
+      for (auto &client : pw->vClients)
+        client->Close();
+    });
+  vWork.clear();
+  for (auto &w : vWorkers) {
+    w->context.stop();
+    w->thr.join();
+  }
+  return 0;
+}
+
+// "16:80,256:15" -> {{16, 80}, {256, 15}}
+std::vector<std::pair<uint32_t, double>> ParseMix(const std::string &sMix) {
+  std::vector<std::pair<uint32_t, double>> vMix;
+  std::stringstream ss(sMix);
+  std::string sItem;
+  while (std::getline(ss, sItem, ',')) {
+    size_t nColon = sItem.find(':');
+    uint32_t nSize = uint32_t(std::stoul(sItem.substr(0, nColon)));
+    double fWeight =
+        nColon == std::string::npos ? 1.0 : std::stod(sItem.substr(nColon + 1));
+    vMix.push_back({nSize, fWeight});
+  }
+  if (vMix.empty())
+    throw std::runtime_error("Empty message mix");
+  return vMix;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string sMode = argc > 1 ? argv[1] : "";
+
+  try {
+    if (sMode == "serve" && argc == 3)
+      return Serve(uint16_t(std::stoul(argv[2])));
+
+    if (sMode == "run" && argc >= 4) {
+      loadgen_options options;
+      options.sHost = argv[2];
+      options.sPort = argv[3];
+
+      for (int i = 4; i + 1 < argc; i += 2) {
+        std::string sArg = argv[i], sValue = argv[i + 1];
+        if (sArg == "--clients")
+          options.nClients = std::stoul(sValue);
+        else if (sArg == "--rate")
+          options.fRate = std::stod(sValue);
+        else if (sArg == "--threads")
+          options.nThreads = std::stoul(sValue);
+        else if (sArg == "--mix")
+          options.vMix = ParseMix(sValue);
+        else if (sArg == "--think")
+          options.fThinkMs = std::stod(sValue);
+        else if (sArg == "--churn")
+          options.fChurnSeconds = std::stod(sValue);
+        else if (sArg == "--duration")
+          options.fDurationSeconds = std::stod(sValue);
+        else if (sArg == "--interval")
+          options.fIntervalSeconds = std::stod(sValue);
+        else if (sArg == "--server-pid")
+          options.nServerPid = std::stoi(sValue);
+        else if (sArg == "--id")
+          options.nMessageId = uint32_t(std::stoul(sValue));
+        else if (sArg == "--source-addrs")
+          options.nSourceAddrs = std::stoul(sValue);
+        else
+          throw std::runtime_error("Unknown option: " + sArg);
+      }
+      return Run(options);
+    }
+  } catch (std::exception &e) {
+    std::cerr << "[LOADGEN] Exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  std::cerr << "Usage: " << argv[0] << " serve <port>\n"
+            << "       " << argv[0] << " run <host> <port> [options]\n"
+            << "See the top of net_loadgen.cpp for the options.\n";
+  return 1;
+}
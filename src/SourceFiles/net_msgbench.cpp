@@ -0,0 +1,131 @@
+// Measures throughput of small messages, the case message<T>'s inline body
+// storage is there for.
+//
+//   local - build a message, push it through a tsqueue, pop it and pull the
+//           last item back out. No sockets, just the cost of the message
+//           representation itself.
+//   wire  - a client_interface sends messages over loopback to a
+//           server_interface, timed until the server has seen them all.
+//
+// Only the public message API is used, so the same file builds against older
+// versions of the library for a before/after comparison.
+//
+// Usage: net_msgbench [--count n] [--wire-count n] [--size bytes] [--port p]
+//   --count n       messages for the local test (2000000)
+//   --wire-count n  messages for the wire test, 0 skips it (300000)
+//   --size bytes    body size, in whole 4 byte words (16)
+//   --port p        loopback port for the wire test (60200)
+
+#include "olc_net.hpp"
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+enum class bench_msg : uint32_t { Data };
+
+class bench_server : public olc::net::server_interface<bench_msg> {
+public:
+  bench_server(uint16_t nPort)
+      : olc::net::server_interface<bench_msg>(nPort) {}
+
+  ~bench_server() {
+    // Connections must go before the asio context they use does
+    Stop();
+    m_deqConnections.clear();
+  }
+
+  size_t nReceived = 0;
+
+protected:
+  bool OnClientConnect(
+      std::shared_ptr<olc::net::connection<bench_msg>> client) override {
+    return true;
+  }
+
+  void OnMessage(std::shared_ptr<olc::net::connection<bench_msg>> client,
+                 olc::net::message<bench_msg> &msg) override {
+    nReceived++;
+  }
+};
+
+olc::net::message<bench_msg> MakeMessage(size_t nWords, uint32_t nValue) {
+  olc::net::message<bench_msg> msg;
+  msg.header.id = bench_msg::Data;
+  for (size_t i = 0; i < nWords; i++)
+    msg << nValue;
+  return msg;
+}
+
+double Rate(size_t nCount, clock_type::time_point tpStart) {
+  return double(nCount) /
+         std::chrono::duration<double>(clock_type::now() - tpStart).count() /
+         1e6;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t nCount = 2000000;
+  size_t nWireCount = 300000;
+  size_t nSize = 16;
+  uint16_t nPort = 60200;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string sArg = argv[i], sValue = argv[i + 1];
+    if (sArg == "--count")
+      nCount = std::stoul(sValue);
+    else if (sArg == "--wire-count")
+      nWireCount = std::stoul(sValue);
+    else if (sArg == "--size")
+      nSize = std::stoul(sValue);
+    else if (sArg == "--port")
+      nPort = uint16_t(std::stoul(sValue));
+    else {
+      std::cerr << "Unknown option: " << sArg << "\n";
+      return 1;
+    }
+  }
+  size_t nWords = std::max<size_t>(nSize / sizeof(uint32_t), 1);
+
+  // Local: the message representation on its own
+  olc::net::tsqueue<olc::net::message<bench_msg>> queue;
+  uint64_t nChecksum = 0;
+  auto tpStart = clock_type::now();
+  for (size_t i = 0; i < nCount; i++) {
+    queue.push_back(MakeMessage(nWords, uint32_t(i)));
+    auto msg = queue.pop_front();
+    uint32_t nValue = 0;
+    msg >> nValue;
+    nChecksum += nValue + msg.size();
+  }
+  std::cout << "[BENCH] local: " << Rate(nCount, tpStart) << " Mmsg/s ("
+            << nWords * sizeof(uint32_t) << " byte bodies, checksum "
+            << nChecksum << ")\n";
+
+  if (nWireCount == 0)
+    return 0;
+
+  // Wire: a client sending to a server over loopback
+  bench_server server(nPort);
+  if (!server.Start())
+    return 1;
+
+  olc::net::client_interface<bench_msg> client;
+  client.Connect("127.0.0.1", nPort);
+  while (!client.IsConnected())
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  tpStart = clock_type::now();
+  for (size_t i = 0; i < nWireCount; i++) {
+    client.Send(MakeMessage(nWords, uint32_t(i)));
+
+    // Keep the server's queue from growing without bound
+    if (i % 1000 == 0)
+      server.Update();
+  }
+  while (server.nReceived < nWireCount)
+    server.Update(-1, true);
+  std::cout << "[BENCH] wire: " << Rate(nWireCount, tpStart) << " Mmsg/s\n";
+
+  client.Disconnect();
+  return 0;
+}
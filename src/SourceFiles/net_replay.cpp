@@ -0,0 +1,169 @@
+// Feeds a capture recorded by a server (see net_capture.hpp) back into a
+// server, so real traffic shapes can be benchmarked and profiled offline.
+//
+// Every connection ID seen in the capture gets its own client socket, opened
+// the first time that ID sends something. Only inbound messages (the ones the
+// server received) are replayed, anything the server sends back is read and
+// thrown away.
+//
+// Usage: net_replay <capture file> <host> <port> [--fast | --speed <factor>]
+//   --fast          send as fast as possible, ignoring the original timing
+//   --speed factor  replay at factor times the original speed (default 1)
+
+#include "net_capture.hpp"
+
+#include <unordered_map>
+
+namespace {
+// A replayed client - writes are queued and sent one after another, and
+// whatever arrives is discarded. Once connected, only ever touched from the
+// asio thread.
+class replay_session {
+public:
+  replay_session(boost::asio::io_context &context) : m_socket(context) {}
+
+  void Connect(const boost::asio::ip::tcp::resolver::results_type &endpoints) {
+    // Connect synchronously, so the first message isn't racing the handshake
+    boost::asio::connect(m_socket, endpoints);
+    m_socket.set_option(boost::asio::ip::tcp::no_delay(true));
+    Read();
+  }
+
+  void Send(std::vector<uint8_t> data) {
+    bool bWritingMessage = !m_deqOut.empty();
+    m_deqOut.push_back(std::move(data));
+    if (!bWritingMessage)
+      Write();
+  }
+
+  void Close() {
+    if (m_socket.is_open())
+      m_socket.close();
+  }
+
+private:
+  void Write() {
+    boost::asio::async_write(
+        m_socket, boost::asio::buffer(m_deqOut.front()),
+        [this](std::error_code ec, std::size_t length) {
+          if (!ec) {
+            m_deqOut.pop_front();
+            if (!m_deqOut.empty())
+              Write();
+          } else {
+            m_deqOut.clear();
+            Close();
+          }
+        });
+  }
+
+  void Read() {
+    m_socket.async_read_some(boost::asio::buffer(m_vReadBuffer),
+                             [this](std::error_code ec, std::size_t length) {
+                               if (!ec)
+                                 Read();
+                             });
+  }
+
+private:
+  boost::asio::ip::tcp::socket m_socket;
+  std::deque<std::vector<uint8_t>> m_deqOut;
+  std::array<uint8_t, 64 * 1024> m_vReadBuffer;
+};
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <capture file> <host> <port> [--fast | --speed <factor>]\n";
+    return 1;
+  }
+
+  bool bFast = false;
+  double fSpeed = 1.0;
+  for (int i = 4; i < argc; i++) {
+    std::string sArg = argv[i];
+    if (sArg == "--fast")
+      bFast = true;
+    else if (sArg == "--speed" && i + 1 < argc)
+      fSpeed = std::max(std::stod(argv[++i]), 1e-6);
+    else {
+      std::cerr << "Unknown option: " << sArg << "\n";
+      return 1;
+    }
+  }
+
+  try {
+    olc::net::capture_reader capture(argv[1]);
+
+    boost::asio::io_context context;
+    auto work = boost::asio::make_work_guard(context);
+    std::thread thrContext([&context]() { context.run(); });
+
+    boost::asio::ip::tcp::resolver resolver(context);
+    auto endpoints = resolver.resolve(argv[2], argv[3]);
+
+    std::unordered_map<uint32_t, std::unique_ptr<replay_session>> mapSessions;
+    size_t nMessages = 0, nBytes = 0;
+
+    auto tpStart = std::chrono::steady_clock::now();
+    std::optional<uint64_t> nFirstTimestamp;
+
+    while (auto record = capture.Next()) {
+      if (record->info.nDirection != olc::net::capture_direction::inbound)
+        continue;
+
+      // Wait until this message is due, relative to the first one
+      if (!nFirstTimestamp)
+        nFirstTimestamp = record->info.nTimestamp;
+      if (!bFast) {
+        // Older captures can have records slightly out of order - those just
+        // go straight away
+        uint64_t nSince = record->info.nTimestamp > *nFirstTimestamp
+                              ? record->info.nTimestamp - *nFirstTimestamp
+                              : 0;
+        auto nDelay =
+            std::chrono::nanoseconds(uint64_t(double(nSince) / fSpeed));
+        std::this_thread::sleep_until(tpStart + nDelay);
+      }
+
+      // First time this connection speaks, it needs a socket of its own
+      auto &session = mapSessions[record->info.nConnectionID];
+      if (!session) {
+        session = std::make_unique<replay_session>(context);
+        session->Connect(endpoints);
+      }
+
+      // The header and body go out exactly as they were captured
+      std::vector<uint8_t> data(record->pHeader, record->pBody +
+                                                     record->info.nBodySize);
+      nBytes += data.size();
+      nMessages++;
+      boost::asio::post(context,
+                        [s = session.get(), d = std::move(data)]() mutable {
+                          s->Send(std::move(d));
+                        });
+    }
+
+    double fSeconds = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - tpStart)
+                          .count();
+    std::cout << "[REPLAY] " << nMessages << " messages, " << nBytes
+              << " bytes over " << mapSessions.size() << " connections in "
+              << fSeconds << "s\n";
+
+    // Give the last writes a moment to drain, then hang up
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    boost::asio::post(context, [&mapSessions]() {
+      for (auto &[id, session] : mapSessions)
+        session->Close();
+    });
+    work.reset();
+    thrContext.join();
+  } catch (std::exception &e) {
+    std::cerr << "[REPLAY] Exception: " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}